@@ -0,0 +1,287 @@
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "structlog.h"
+
+Register_PerRunConfigOption(CFGID_STRUCTLOG_MODE, "structlog-mode", CFG_STRING, "off",
+        "Structured logging of SLOG() call sites: off, text or binary");
+Register_PerRunConfigOption(CFGID_STRUCTLOG_FILE, "structlog-file", CFG_FILENAME,
+        "${resultdir}/${configname}-${iterationvarsf}#${repetition}.slog",
+        "Output file of structured logging");
+
+namespace {
+
+const int BINARY_VERSION = 1;
+const char *BINARY_LAYOUT = "little-endian int32 formatId, int32 sourceId, int64 simtime, uint8 numArgs, "
+        "numArgs * (uint8 type, 8-byte value: int64 for i/t/s, double for d)";
+
+// Single producer (simulation thread), single consumer (writer thread)
+const int RING_SIZE = 1 << 14;
+StructLog::Record ring[RING_SIZE];
+std::atomic<unsigned> ringHead(0);
+std::atomic<unsigned> ringTail(0);
+
+// Format strings indexed by format id, filled before first use
+const int MAX_FORMATS = 4096;
+const char *formats[MAX_FORMATS];
+std::atomic<int> numFormats(0);
+
+// Module paths indexed by component id; only written when a module
+// logs for the first time in a run, so a mutex is cheap enough here
+std::mutex sourcesMutex;
+std::vector<std::string> sourcePaths;
+
+// String arguments of the binary log, only used by the writer thread
+std::unordered_map<const char *, int> stringIds;
+std::vector<const char *> strings;
+
+std::thread writer;
+std::atomic<bool> writerRunning(false);
+bool binaryMode = false;
+FILE *out = nullptr;
+std::string outFileName;
+
+std::string getSourcePath(int id)
+{
+    std::lock_guard<std::mutex> lock(sourcesMutex);
+    return sourcePaths[id];
+}
+
+// Creates the directories of path, as the default file is in ${resultdir}
+void makeDirectoriesFor(const std::string& path)
+{
+    for (size_t pos = path.find('/', 1); pos != std::string::npos; pos = path.find('/', pos + 1))
+        mkdir(path.substr(0, pos).c_str(), 0777);
+}
+
+void writeInt(uint64_t value, int bytes)
+{
+    for (int i = 0; i < bytes; i++)
+        fputc((int)((value >> (8 * i)) & 0xFF), out);
+}
+
+void writeBinaryRecord(const StructLog::Record& record)
+{
+    writeInt((uint32_t)record.formatId, 4);
+    writeInt((uint32_t)record.sourceId, 4);
+    writeInt((uint64_t)record.simtimeRaw, 8);
+    writeInt((uint8_t)record.numArgs, 1);
+    for (int i = 0; i < record.numArgs; i++) {
+        const StructLog::Arg& a = record.args[i];
+        writeInt((uint8_t)a.type, 1);
+        uint64_t value;
+        if (a.type == 'd')
+            memcpy(&value, &a.d, sizeof(value));
+        else if (a.type == 's') {
+            // Strings are interned and written to the .fmt table
+            auto it = stringIds.find(a.s);
+            if (it == stringIds.end()) {
+                it = stringIds.emplace(a.s, (int)strings.size()).first;
+                strings.push_back(a.s);
+            }
+            value = it->second;
+        }
+        else
+            value = (uint64_t)a.i;
+        writeInt(value, 8);
+    }
+}
+
+void writeTextRecord(const StructLog::Record& record)
+{
+    std::string line = "[" + SimTime().setRaw(record.simtimeRaw).str() + "] " + getSourcePath(record.sourceId) + ": ";
+    StructLog::appendFormatted(line, formats[record.formatId], record.args, record.numArgs);
+    line += '\n';
+    fputs(line.c_str(), out);
+}
+
+// Drains the ring until logging is stopped and the ring is empty
+void writerLoop()
+{
+    while (true) {
+        unsigned tail = ringTail.load(std::memory_order_relaxed);
+        if (tail == ringHead.load(std::memory_order_acquire)) {
+            if (!writerRunning.load())
+                break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        const StructLog::Record& record = ring[tail % RING_SIZE];
+        if (binaryMode)
+            writeBinaryRecord(record);
+        else
+            writeTextRecord(record);
+        ringTail.store(tail + 1, std::memory_order_release);
+    }
+}
+
+std::string escape(const char *text)
+{
+    std::string result;
+    for (const char *p = text; *p; p++) {
+        if (*p == '\\')
+            result += "\\\\";
+        else if (*p == '\n')
+            result += "\\n";
+        else
+            result += *p;
+    }
+    return result;
+}
+
+// Called once the writer has been joined
+void writeFormatTable()
+{
+    FILE *f = fopen((outFileName + ".fmt").c_str(), "w");
+    if (!f)
+        throw cRuntimeError("Cannot open structlog format table '%s.fmt'", outFileName.c_str());
+    fprintf(f, "V %d\n", BINARY_VERSION);
+    fprintf(f, "E %d\n", SimTime::getScaleExp());
+    fprintf(f, "L %s\n", BINARY_LAYOUT);
+    for (int i = 0; i < numFormats.load(); i++)
+        fprintf(f, "F %d %s\n", i, escape(formats[i]).c_str());
+    for (int i = 0; i < (int)sourcePaths.size(); i++)
+        if (!sourcePaths[i].empty())
+            fprintf(f, "S %d %s\n", i, escape(sourcePaths[i].c_str()).c_str());
+    for (int i = 0; i < (int)strings.size(); i++)
+        fprintf(f, "T %d %s\n", i, escape(strings[i]).c_str());
+    fclose(f);
+}
+
+// Starts logging when the network is about to initialize and stops
+// when the run ends, fails or its network is deleted, so every run
+// gets its own log file and the writer never outlives its run
+class StructLogLifecycleListener : public cISimulationLifecycleListener
+{
+    protected:
+        virtual void lifecycleEvent(SimulationLifecycleEventType eventType, cObject *details) override
+        {
+            switch (eventType) {
+                case LF_PRE_NETWORK_INITIALIZE:
+                    StructLog::start();
+                    break;
+                case LF_ON_RUN_END:
+                case LF_ON_SIMULATION_ERROR:
+                case LF_PRE_NETWORK_DELETE:
+                    StructLog::stop();
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        virtual void listenerRemoved() override
+        {
+            delete this;
+        }
+};
+
+}
+
+EXECUTE_ON_STARTUP(getEnvir()->addLifecycleListener(new StructLogLifecycleListener()));
+EXECUTE_ON_SHUTDOWN(StructLog::stop());
+
+std::atomic<bool> StructLog::enabled(false);
+
+int StructLog::registerFormat(const char *format)
+{
+    int id = numFormats.load();
+    if (id == MAX_FORMATS)
+        throw cRuntimeError("Too many structlog format strings");
+    formats[id] = format;
+    numFormats.store(id + 1, std::memory_order_release);
+    return id;
+}
+
+int StructLog::registerSource(const cComponent *source)
+{
+    // The simulation thread is the only one growing the table
+    int id = source->getId();
+    if (id < (int)sourcePaths.size() && !sourcePaths[id].empty())
+        return id;
+    std::lock_guard<std::mutex> lock(sourcesMutex);
+    if (id >= (int)sourcePaths.size())
+        sourcePaths.resize(id + 1);
+    sourcePaths[id] = source->getFullPath();
+    return id;
+}
+
+void StructLog::push(const Record& record)
+{
+    unsigned head = ringHead.load(std::memory_order_relaxed);
+    // Ring full: wait for the writer rather than losing records
+    while (head - ringTail.load(std::memory_order_acquire) == RING_SIZE)
+        std::this_thread::yield();
+    ring[head % RING_SIZE] = record;
+    ringHead.store(head + 1, std::memory_order_release);
+}
+
+void StructLog::appendFormatted(std::string& out, const char *format, const Arg *args, int numArgs)
+{
+    char buf[32];
+    int arg = 0;
+    for (const char *p = format; *p; p++) {
+        if (p[0] == '{' && p[1] == '}' && arg < numArgs) {
+            const Arg& a = args[arg++];
+            switch (a.type) {
+                case 'i': snprintf(buf, sizeof(buf), "%lld", (long long)a.i); out += buf; break;
+                case 'd': snprintf(buf, sizeof(buf), "%g", a.d); out += buf; break;
+                case 't': out += SimTime().setRaw(a.i).str(); break;
+                case 's': out += a.s; break;
+            }
+            p++;
+        }
+        else
+            out += *p;
+    }
+}
+
+void StructLog::start()
+{
+    // A run that failed or was rebuilt before reaching its end
+    // may have left the writer running
+    stop();
+    {
+        // Component ids are reused by later runs of the same process
+        std::lock_guard<std::mutex> lock(sourcesMutex);
+        sourcePaths.clear();
+    }
+    stringIds.clear();
+    strings.clear();
+
+    cConfiguration *config = getEnvir()->getConfig();
+    std::string mode = config->getAsString(CFGID_STRUCTLOG_MODE);
+    if (mode == "off")
+        return;
+    if (mode != "text" && mode != "binary")
+        throw cRuntimeError("Invalid structlog-mode '%s', must be off, text or binary", mode.c_str());
+    binaryMode = mode == "binary";
+    outFileName = config->getAsFilename(CFGID_STRUCTLOG_FILE);
+    makeDirectoriesFor(outFileName);
+    out = fopen(outFileName.c_str(), binaryMode ? "wb" : "w");
+    if (!out)
+        throw cRuntimeError("Cannot open structlog file '%s'", outFileName.c_str());
+    ringHead = ringTail = 0;
+    writerRunning = true;
+    writer = std::thread(writerLoop);
+    enabled = true;
+}
+
+void StructLog::stop()
+{
+    if (!writer.joinable())
+        return;
+    enabled = false;
+    writerRunning = false;
+    writer.join();
+    fclose(out);
+    out = nullptr;
+    if (binaryMode)
+        writeFormatTable();
+}
@@ -0,0 +1,138 @@
+#ifndef STRUCTLOG_H_
+#define STRUCTLOG_H_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <omnetpp.h>
+
+using namespace omnetpp;
+
+//
+// Structured logging with deferred formatting. A call site only stores
+// the id of its (static) format string and the raw argument values in
+// a lock-free ring buffer; a background thread does the formatting and
+// the file I/O, so the simulation thread never waits on a flush.
+// While structured logging is off, SLOG() formats at once and writes
+// to EV, so the messages still show up in Cmdenv and Qtenv.
+//
+// Format strings use "{}" as placeholder for each argument. Arguments
+// may be integers, doubles, simtime_t or string literals (the pointer
+// is stored, so the string must live until the end of the run).
+//
+// Configured per run in omnetpp.ini:
+//   structlog-mode = off | text | binary
+//   structlog-file = <file name>
+//
+// The binary file is a sequence of little-endian records:
+//   int32 format id, int32 source id, int64 raw simtime, uint8 number
+//   of arguments, then per argument a uint8 type ('i' integer, 'd'
+//   IEEE-754 double, 't' raw simtime, 's' string id) and an 8-byte value.
+// The "<file>.fmt" side file holds one entry per line, with '\' and
+// newlines escaped as "\\" and "\n":
+//   V <format version>
+//   E <simtime scale exponent>
+//   L <record layout, as above>
+//   F <id> <format string>
+//   S <id> <module path>
+//   T <id> <string argument>
+//
+class StructLog
+{
+    public:
+        static const int MAX_ARGS = 4;
+
+        struct Arg
+        {
+            // 'i' integer, 'd' double, 't' raw simtime, 's' string
+            char type;
+            union {
+                int64_t i;
+                double d;
+                const char *s;
+            };
+        };
+
+        struct Record
+        {
+            int formatId;
+            int sourceId;
+            int64_t simtimeRaw;
+            int numArgs;
+            Arg args[MAX_ARGS];
+        };
+
+    private:
+        // Set while a run is being logged; checked by every call site
+        static std::atomic<bool> enabled;
+
+    public:
+        static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+        // Called once per call site, the result is kept in a static local
+        static int registerFormat(const char *format);
+
+        template<typename... Args>
+        static void log(int formatId, const cComponent *source, Args... args)
+        {
+            static_assert(sizeof...(args) <= MAX_ARGS, "too many structlog arguments");
+            Record record;
+            record.formatId = formatId;
+            record.sourceId = registerSource(source);
+            record.simtimeRaw = simTime().raw();
+            record.numArgs = sizeof...(args);
+            Arg packed[] = { makeArg(args)..., Arg() };
+            for (int i = 0; i < record.numArgs; i++)
+                record.args[i] = packed[i];
+            push(record);
+        }
+
+        // Formats on the spot, for the EV fallback
+        template<typename... Args>
+        static std::string format(const char *format, Args... args)
+        {
+            static_assert(sizeof...(args) <= MAX_ARGS, "too many structlog arguments");
+            Arg packed[] = { makeArg(args)..., Arg() };
+            std::string result;
+            appendFormatted(result, format, packed, sizeof...(args));
+            return result;
+        }
+
+        // Replaces each "{}" of format with the next argument
+        static void appendFormatted(std::string& out, const char *format, const Arg *args, int numArgs);
+
+        // Starts and stops logging of the current run
+        static void start();
+        static void stop();
+
+    private:
+        static int registerSource(const cComponent *source);
+        static void push(const Record& record);
+
+        static Arg makeArg(int v) { Arg a; a.type = 'i'; a.i = v; return a; }
+        static Arg makeArg(long v) { Arg a; a.type = 'i'; a.i = v; return a; }
+        static Arg makeArg(long long v) { Arg a; a.type = 'i'; a.i = v; return a; }
+        static Arg makeArg(unsigned int v) { Arg a; a.type = 'i'; a.i = v; return a; }
+        static Arg makeArg(double v) { Arg a; a.type = 'd'; a.d = v; return a; }
+        static Arg makeArg(const SimTime& v) { Arg a; a.type = 't'; a.i = v.raw(); return a; }
+        static Arg makeArg(const char *v) { Arg a; a.type = 's'; a.s = v; return a; }
+};
+
+//
+// Logs at info level from a module. With structured logging on, only
+// the global and the module's log level (e.g. **.cmdenv-log-level) are
+// checked, so records are kept in Cmdenv express mode too; otherwise
+// it is plain EV_INFO, with the usual EV checks. Usage:
+//   SLOG("Message arrived, starting {} secs processing...", delay);
+//
+#define SLOG(fmt, ...) \
+    do { \
+        static const int slogFormatId_ = StructLog::registerFormat(fmt); \
+        if (StructLog::isEnabled()) { \
+            if (LOGLEVEL_INFO >= cLog::logLevel && LOGLEVEL_INFO >= getLogLevel()) \
+                StructLog::log(slogFormatId_, this, ##__VA_ARGS__); \
+        } \
+        else \
+            EV_INFO << StructLog::format(fmt, ##__VA_ARGS__) << "\n"; \
+    } while (0)
+
+#endif
@@ -2,6 +2,7 @@
 #include <string.h>
 #include <omnetpp.h>
 #include "pingpong_m.h"
+#include "structlog.h"
 
 using namespace omnetpp;
 
@@ -76,7 +77,7 @@ void Node::initialize()
     // using a scheduled self-message
     if (par("sendMsgOnInit").boolValue())
     {
-        EV << "Scheduling the first sending to t = 5.0s\n";
+        SLOG("Scheduling the first sending to t = 5.0s");
         scheduleAt(5.0, processingEvent);
     }
 }
@@ -87,7 +88,7 @@ void Node::handleMessage(cMessage *msg)
     {
         // If the arriving message is the processing self-message
         // sends the message stored in the buffer.
-        EV << "Internal processing finished. Sending a new message.\n";
+        SLOG("Internal processing finished. Sending a new message.");
         messageBuffer = generateNewMessage();
         sendCopyOf(messageBuffer);
         // Begins the timeout counter
@@ -97,7 +98,7 @@ void Node::handleMessage(cMessage *msg)
     {
         // If the arriving message is the timeout,
         // resends the message in the buffer.
-        EV << "Message timeout reached. Sending again and restarting timer.\n";
+        SLOG("Message timeout reached. Sending again and restarting timer.");
         messageBuffer->setSendingTime(simTime());
         sendCopyOf(messageBuffer);
         scheduleAt(simTime() + timeout, timeoutEvent);
@@ -112,7 +113,7 @@ void Node::handleMessage(cMessage *msg)
         cancelEvent(processingEvent);
         // With a small probability, the message will be lost
         if (uniform(0, 1) < loss) {
-            EV << "Losing message\n";
+            SLOG("Losing message");
             delete msg;
             return;
         }
@@ -120,7 +121,7 @@ void Node::handleMessage(cMessage *msg)
         simtime_t latency = simTime() - extmsg->getSendingTime();
         // Stores it and starts the processing timer
         simtime_t delay = par("processingTime");
-        EV << "Message arrived, starting " << delay << " secs processing...\n";
+        SLOG("Message arrived, starting {} secs processing...", delay);
         messageBuffer = extmsg;
         messageBuffer->setProcessingTime(delay);
         messageBuffer->setRecvTime(0);
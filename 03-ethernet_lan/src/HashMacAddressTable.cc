@@ -0,0 +1,170 @@
+#include <unordered_map>
+#include <omnetpp.h>
+#include "inet/linklayer/ethernet/switch/IMacAddressTable.h"
+
+using namespace omnetpp;
+using namespace inet;
+
+class HashMacAddressTable : public cSimpleModule, public IMacAddressTable
+{
+    private:
+        struct AddressEntry
+        {
+            int portno;
+            simtime_t insertionTime;
+        };
+        // Key packs the VLAN id above the 48 bits of the MAC address,
+        // so a single flat table holds every VLAN
+        typedef std::unordered_map<uint64_t, AddressEntry> AddressTable;
+        AddressTable addressTable;
+
+        //// External parameters
+        // Entries older than this are considered stale
+        simtime_t agingTime;
+        // Aging time restored by resetDefaultAging()
+        simtime_t defaultAgingTime;
+
+        // Last time the whole table was purged of stale entries
+        simtime_t lastPurge;
+
+    protected:
+        virtual void initialize() override;
+        virtual void handleMessage(cMessage *msg) override;
+        virtual void refreshDisplay() const override;
+        static uint64_t makeKey(const MacAddress& address, unsigned int vid);
+
+    public:
+        virtual int getPortForAddress(const MacAddress& address, unsigned int vid = 0) override;
+        virtual bool updateTableWithAddress(int portno, const MacAddress& address, unsigned int vid = 0) override;
+        virtual void flush(int portno) override;
+        virtual void printState() override;
+        virtual void copyTable(int portA, int portB) override;
+        virtual void removeAgedEntriesFromAllVlans() override;
+        virtual void removeAgedEntriesIfNeeded() override;
+        virtual void clearTable() override;
+        virtual void setAgingTime(simtime_t agingTime) override;
+        virtual void resetDefaultAging() override;
+};
+
+Define_Module(HashMacAddressTable);
+
+void HashMacAddressTable::initialize()
+{
+    agingTime = defaultAgingTime = par("agingTime");
+    lastPurge = SIMTIME_ZERO;
+    // Sizing the buckets up front avoids rehashing while the
+    // switch learns the campus during the first broadcasts
+    addressTable.reserve(par("expectedEntries").intValue());
+}
+
+void HashMacAddressTable::handleMessage(cMessage *msg)
+{
+    throw cRuntimeError("This module doesn't process messages");
+}
+
+void HashMacAddressTable::refreshDisplay() const
+{
+    char buf[32];
+    sprintf(buf, "addresses: %d", (int)addressTable.size());
+    getDisplayString().setTagArg("t", 0, buf);
+}
+
+uint64_t HashMacAddressTable::makeKey(const MacAddress& address, unsigned int vid)
+{
+    return ((uint64_t)vid << 48) | address.getInt();
+}
+
+int HashMacAddressTable::getPortForAddress(const MacAddress& address, unsigned int vid)
+{
+    Enter_Method_Silent();
+    auto it = addressTable.find(makeKey(address, vid));
+    if (it == addressTable.end())
+        return -1;
+    // Stale entries are dropped lazily when they are looked up
+    if (it->second.insertionTime + agingTime <= simTime()) {
+        EV << "Ignoring and deleting aged entry: " << address << " --> port " << it->second.portno << "\n";
+        addressTable.erase(it);
+        return -1;
+    }
+    return it->second.portno;
+}
+
+bool HashMacAddressTable::updateTableWithAddress(int portno, const MacAddress& address, unsigned int vid)
+{
+    Enter_Method_Silent();
+    if (address.isBroadcast())
+        return false;
+    removeAgedEntriesIfNeeded();
+    // Same contract as INET's MacAddressTable: false for a newly
+    // learned address, true when an existing entry is refreshed
+    auto result = addressTable.emplace(makeKey(address, vid), AddressEntry{portno, simTime()});
+    if (result.second)
+        return false;
+    // Known address: refresh it, possibly on a new port
+    result.first->second.portno = portno;
+    result.first->second.insertionTime = simTime();
+    return true;
+}
+
+void HashMacAddressTable::flush(int portno)
+{
+    Enter_Method("flush(%d)", portno);
+    for (auto it = addressTable.begin(); it != addressTable.end(); ) {
+        if (it->second.portno == portno)
+            it = addressTable.erase(it);
+        else
+            ++it;
+    }
+}
+
+void HashMacAddressTable::printState()
+{
+    EV << "MAC Address Table (" << addressTable.size() << " entries)\n";
+    EV << "VLAN ID    MAC    Port    Inserted\n";
+    for (auto& entry : addressTable)
+        EV << (entry.first >> 48) << "   " << MacAddress(entry.first & 0xFFFFFFFFFFFFULL) << "   "
+           << entry.second.portno << "   " << entry.second.insertionTime << "\n";
+}
+
+void HashMacAddressTable::copyTable(int portA, int portB)
+{
+    for (auto& entry : addressTable)
+        if (entry.second.portno == portA)
+            entry.second.portno = portB;
+}
+
+void HashMacAddressTable::removeAgedEntriesFromAllVlans()
+{
+    simtime_t now = simTime();
+    for (auto it = addressTable.begin(); it != addressTable.end(); ) {
+        if (it->second.insertionTime + agingTime <= now)
+            it = addressTable.erase(it);
+        else
+            ++it;
+    }
+}
+
+void HashMacAddressTable::removeAgedEntriesIfNeeded()
+{
+    // A full sweep is linear, so it runs at most once per aging period
+    simtime_t now = simTime();
+    if (now >= lastPurge + agingTime) {
+        removeAgedEntriesFromAllVlans();
+        lastPurge = now;
+    }
+}
+
+void HashMacAddressTable::clearTable()
+{
+    addressTable.clear();
+}
+
+void HashMacAddressTable::setAgingTime(simtime_t agingTime)
+{
+    this->agingTime = agingTime;
+}
+
+void HashMacAddressTable::resetDefaultAging()
+{
+    agingTime = defaultAgingTime;
+}
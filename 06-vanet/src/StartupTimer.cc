@@ -0,0 +1,73 @@
+#include <chrono>
+#include <iostream>
+#include <omnetpp.h>
+
+using namespace omnetpp;
+
+// Prints how long each startup phase took, so the fixed cost of a run
+// (NED loading, network building, initialization with its XML parsing
+// and SUMO connection) can be told apart from the simulation itself.
+class StartupTimer : public cISimulationLifecycleListener
+{
+    private:
+        typedef std::chrono::steady_clock Clock;
+        // Start of the phase being measured
+        Clock::time_point phaseStart;
+        // Process start, or the deletion of the previous network when
+        // several runs share one process and reuse the loaded NED types
+        Clock::time_point runStart;
+
+    public:
+        StartupTimer();
+
+    protected:
+        virtual void lifecycleEvent(SimulationLifecycleEventType eventType, cObject *details) override;
+        virtual void listenerRemoved() override;
+        void printPhase(const char *phase);
+};
+
+EXECUTE_ON_STARTUP(getEnvir()->addLifecycleListener(new StartupTimer()));
+
+StartupTimer::StartupTimer()
+{
+    phaseStart = runStart = Clock::now();
+}
+
+void StartupTimer::lifecycleEvent(SimulationLifecycleEventType eventType, cObject *details)
+{
+    switch (eventType) {
+        case LF_PRE_NETWORK_SETUP:
+            // Everything before the network is built: ini and NED loading
+            printPhase("loading ini and NED files");
+            break;
+        case LF_POST_NETWORK_SETUP:
+            printPhase("building the network");
+            break;
+        case LF_POST_NETWORK_INITIALIZE:
+            // Includes the xmldoc() parsing and the TraCI connection
+            printPhase("initializing modules");
+            std::cout << "Startup total: "
+                      << std::chrono::duration<double>(Clock::now() - runStart).count() << "s" << std::endl;
+            break;
+        case LF_POST_NETWORK_DELETE:
+            // Leaves finish() and the teardown of the previous run
+            // out of the next run's loading phase
+            phaseStart = runStart = Clock::now();
+            break;
+        default:
+            break;
+    }
+}
+
+void StartupTimer::listenerRemoved()
+{
+    delete this;
+}
+
+void StartupTimer::printPhase(const char *phase)
+{
+    Clock::time_point now = Clock::now();
+    std::cout << "Startup phase: " << phase << " took "
+              << std::chrono::duration<double>(now - phaseStart).count() << "s" << std::endl;
+    phaseStart = now;
+}